@@ -2,6 +2,41 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Transposed (bit-sliced) view of the test set: for every bit position, one bitset over all vectors
+// marking the vectors that hold a '1' there and one marking those that hold a '0'
+typedef struct
+{
+    int inputVectorsCount;
+    int inputVectorLength;
+    int words;                   // 64-bit words per bitset in use
+    int capacity;                // vectors the bitsets were allocated for
+    unsigned long long **ones;   // ones[k] has bit v set when vector v is '1' at position k
+    unsigned long long **zeros;  // zeros[k] has bit v set when vector v is '0' at position k
+    unsigned long long *members; // scratch bitset for clique membership
+    unsigned long long *pending; // scratch bitset of vectors no entry has matched yet
+} BitSlices;
+
+// Compatibility graph, stored either as an int adjacency matrix or as packed 64-bit rows
+typedef struct
+{
+    int inputVectorsCount;
+    int packed;                 // 1 when rows are stored in bits instead of the matrix
+    int words;                  // 64-bit words per packed row
+    int **matrix;               // matrix[i][j] is 1 when vectors i and j are compatible
+    unsigned long long **bits;  // bits[i] has bit j set when vectors i and j are compatible
+} Graph;
+
+// Buffers sized once and reused by every largestClique call, plus the storage for the extracted cliques
+typedef struct
+{
+    int *candidate;                    // clique grown from the current seed
+    int *best;                         // largest clique found so far, -1 terminated
+    unsigned long long *candidateBits; // vertices adjacent to every candidate member (packed engine)
+    int *arena;                        // extracted cliques, each -1 terminated, stored back to back
+    int arenaCapacity;
+    int arenaUsed;
+} CliqueWorkspace;
+
 // Function to check compatibility between two input vectors
 int isCompatible(const char *inputVector1, const char *inputVector2, int inputVectorLength)
 {
@@ -25,7 +60,8 @@ char **readInputVectorsFromInputFile(const char *inputFileName, int *inputVector
         exit(1);
     }
 
-    char **vectors = (char **)malloc(20000 * sizeof(char *));
+    int capacity = 20000;
+    char **vectors = (char **)malloc(capacity * sizeof(char *));
     if (!vectors)
     {
         printf("Memory allocation failed for vectors.\n");
@@ -36,6 +72,16 @@ char **readInputVectorsFromInputFile(const char *inputFileName, int *inputVector
 
     while (fscanf(file, "%s", line) != EOF)
     {
+        if (*inputVectorsCount == capacity)
+        {
+            capacity *= 2;
+            vectors = (char **)realloc(vectors, capacity * sizeof(char *));
+            if (!vectors)
+            {
+                printf("Memory allocation failed for vectors.\n");
+                exit(1);
+            }
+        }
         vectors[*inputVectorsCount] = (char *)malloc((inputVectorLength + 1) * sizeof(char));
         if (!vectors[*inputVectorsCount])
         {
@@ -49,19 +95,96 @@ char **readInputVectorsFromInputFile(const char *inputFileName, int *inputVector
     return vectors;
 }
 
-// Function to build a compatibility graph
-int **constructGraph(char **vectors, int inputVectorsCount, int inputVectorLength)
+// Function to allocate an empty compatibility graph in the requested layout
+Graph *createGraph(int inputVectorsCount, int packed)
 {
-    int **graph = (int **)malloc(inputVectorsCount * sizeof(int *));
-    for (int i = 0; i < inputVectorsCount; i++)
+    Graph *graph = (Graph *)calloc(1, sizeof(Graph));
+    if (!graph)
+    {
+        printf("Memory allocation failed for graph.\n");
+        exit(1);
+    }
+    graph->inputVectorsCount = inputVectorsCount;
+    graph->packed = packed;
+    graph->words = (inputVectorsCount + 63) / 64;
+
+    if (packed)
+    {
+        graph->bits = (unsigned long long **)malloc(inputVectorsCount * sizeof(unsigned long long *));
+        if (inputVectorsCount && !graph->bits)
+        {
+            printf("Memory allocation failed for graph.\n");
+            exit(1);
+        }
+        for (int i = 0; i < inputVectorsCount; i++)
+        {
+            graph->bits[i] = (unsigned long long *)calloc(graph->words, sizeof(unsigned long long));
+            if (!graph->bits[i])
+            {
+                printf("Memory allocation failed for graph row %d.\n", i);
+                exit(1);
+            }
+        }
+    }
+    else
     {
-        graph[i] = (int *)calloc(inputVectorsCount, sizeof(int));
-        if (!graph[i])
+        graph->matrix = (int **)malloc(inputVectorsCount * sizeof(int *));
+        if (inputVectorsCount && !graph->matrix)
         {
-            printf("Memory allocation failed for graph row %d.\n", i);
+            printf("Memory allocation failed for graph.\n");
             exit(1);
         }
+        for (int i = 0; i < inputVectorsCount; i++)
+        {
+            graph->matrix[i] = (int *)calloc(inputVectorsCount, sizeof(int));
+            if (!graph->matrix[i])
+            {
+                printf("Memory allocation failed for graph row %d.\n", i);
+                exit(1);
+            }
+        }
+    }
+    return graph;
+}
+
+void freeGraph(Graph *graph)
+{
+    for (int i = 0; i < graph->inputVectorsCount; i++)
+    {
+        if (graph->packed)
+            free(graph->bits[i]);
+        else
+            free(graph->matrix[i]);
+    }
+    free(graph->bits);
+    free(graph->matrix);
+    free(graph);
+}
+
+int hasEdge(const Graph *graph, int i, int j)
+{
+    if (graph->packed)
+        return (graph->bits[i][j / 64] >> (j % 64)) & 1;
+    return graph->matrix[i][j];
+}
+
+void addEdge(Graph *graph, int i, int j)
+{
+    if (graph->packed)
+    {
+        graph->bits[i][j / 64] |= 1ULL << (j % 64);
+        graph->bits[j][i / 64] |= 1ULL << (i % 64);
     }
+    else
+    {
+        graph->matrix[i][j] = graph->matrix[j][i] = 1;
+    }
+}
+
+// Function to build a compatibility graph
+Graph *constructGraph(char **vectors, int inputVectorsCount, int inputVectorLength, int packed)
+{
+    Graph *graph = createGraph(inputVectorsCount, packed);
 
     for (int i = 0; i < inputVectorsCount; i++)
     {
@@ -69,36 +192,70 @@ int **constructGraph(char **vectors, int inputVectorsCount, int inputVectorLengt
         {
             if (isCompatible(vectors[i], vectors[j], inputVectorLength))
             {
-                graph[i][j] = graph[j][i] = 1;
+                addEdge(graph, i, j);
             }
         }
     }
     return graph;
 }
 
-// Function to find the largest clique in the current graph
-int *largestClique(int **graph, int inputVectorsCount, int *available, int *cliqueSize)
+// Function to allocate the clique workspace once for a graph of inputVectorsCount vertices
+// The arena holds every extracted clique: members are disjoint, so n vertices plus one terminator per clique
+CliqueWorkspace *createWorkspace(int inputVectorsCount, int maxCliques)
+{
+    CliqueWorkspace *ws = (CliqueWorkspace *)malloc(sizeof(CliqueWorkspace));
+    if (!ws)
+    {
+        printf("Memory allocation failed for clique workspace.\n");
+        exit(1);
+    }
+    ws->arenaCapacity = inputVectorsCount + maxCliques;
+    ws->arenaUsed = 0;
+    ws->candidate = (int *)malloc((inputVectorsCount + 1) * sizeof(int));
+    ws->best = (int *)malloc((inputVectorsCount + 1) * sizeof(int));
+    ws->candidateBits = (unsigned long long *)malloc(((inputVectorsCount + 63) / 64 + 1) * sizeof(unsigned long long));
+    ws->arena = (int *)malloc((ws->arenaCapacity + 1) * sizeof(int));
+    if (!ws->candidate || !ws->best || !ws->candidateBits || !ws->arena)
+    {
+        printf("Memory allocation failed for clique workspace.\n");
+        exit(1);
+    }
+    return ws;
+}
+
+void freeWorkspace(CliqueWorkspace *ws)
+{
+    free(ws->candidate);
+    free(ws->best);
+    free(ws->candidateBits);
+    free(ws->arena);
+    free(ws);
+}
+
+// Function to find the largest clique in the current graph using the int matrix
+int largestCliqueMatrix(const Graph *graph, const int *available, CliqueWorkspace *ws)
 {
-    int *clique = (int *)malloc((inputVectorsCount + 1) * sizeof(int));
-    *cliqueSize = 0;
+    int inputVectorsCount = graph->inputVectorsCount;
+    int **matrix = graph->matrix;
+    int *tempClique = ws->candidate;
+    int cliqueSize = 0;
 
     for (int v = 0; v < inputVectorsCount; v++)
     {
         if (!available[v])
             continue;
 
-        int tempClique[inputVectorsCount];
         int tempSize = 0;
         tempClique[tempSize++] = v;
 
         for (int i = 0; i < inputVectorsCount; i++)
         {
-            if (graph[v][i] == 1 && available[i])
+            if (matrix[v][i] == 1 && available[i])
             {
                 int canAdd = 1;
                 for (int j = 0; j < tempSize; j++)
                 {
-                    if (graph[tempClique[j]][i] == 0)
+                    if (matrix[tempClique[j]][i] == 0)
                     {
                         canAdd = 0;
                         break;
@@ -109,59 +266,264 @@ int *largestClique(int **graph, int inputVectorsCount, int *available, int *cliq
             }
         }
 
-        if (tempSize > *cliqueSize)
+        if (tempSize > cliqueSize)
+        {
+            cliqueSize = tempSize;
+            memcpy(ws->best, tempClique, tempSize * sizeof(int));
+            ws->best[tempSize] = -1;
+        }
+    }
+    return cliqueSize;
+}
+
+// Function to find the largest clique in the current graph using packed rows
+// Same greedy order as the matrix engine: the candidate set is the AND of the rows of every member so far
+int largestCliquePacked(const Graph *graph, const int *available, CliqueWorkspace *ws)
+{
+    int inputVectorsCount = graph->inputVectorsCount;
+    int words = graph->words;
+    unsigned long long *candidates = ws->candidateBits;
+    int *tempClique = ws->candidate;
+    int cliqueSize = 0;
+
+    for (int v = 0; v < inputVectorsCount; v++)
+    {
+        if (!available[v])
+            continue;
+
+        int tempSize = 0;
+        tempClique[tempSize++] = v;
+        memcpy(candidates, graph->bits[v], words * sizeof(unsigned long long));
+
+        for (int w = 0; w < words; w++)
         {
-            *cliqueSize = tempSize;
-            for (int i = 0; i < tempSize; i++)
+            while (candidates[w])
             {
-                clique[i] = tempClique[i];
+                int i = w * 64 + __builtin_ctzll(candidates[w]);
+                tempClique[tempSize++] = i;
+                for (int k = w; k < words; k++)
+                    candidates[k] &= graph->bits[i][k];
             }
-            clique[tempSize] = -1;
+        }
+
+        if (tempSize > cliqueSize)
+        {
+            cliqueSize = tempSize;
+            memcpy(ws->best, tempClique, tempSize * sizeof(int));
+            ws->best[tempSize] = -1;
         }
     }
-    return clique;
+    return cliqueSize;
+}
+
+// Function to find the largest clique in the current graph; the clique is left in ws->best
+int largestClique(const Graph *graph, const int *available, CliqueWorkspace *ws)
+{
+    if (graph->packed)
+        return largestCliquePacked(graph, available, ws);
+    return largestCliqueMatrix(graph, available, ws);
 }
 
 // Function to remove a clique from the graph
-void removeCliquesFromGraph(int *clique, int **graph, int inputVectorsCount, int *available)
+void removeCliquesFromGraph(const int *clique, Graph *graph, int *available)
 {
     for (int i = 0; clique[i] != -1; i++)
     {
         int vertex = clique[i];
         available[vertex] = 0;
-        for (int j = 0; j < inputVectorsCount; j++)
+        for (int j = 0; j < graph->inputVectorsCount; j++)
+        {
+            if (graph->packed)
+                graph->bits[j][vertex / 64] &= ~(1ULL << (vertex % 64));
+            else
+                graph->matrix[vertex][j] = graph->matrix[j][vertex] = 0;
+        }
+        if (graph->packed)
+            memset(graph->bits[vertex], 0, graph->words * sizeof(unsigned long long));
+    }
+}
+
+// Function to allocate an empty bit-sliced view for up to capacity vectors
+BitSlices *createBitSlices(int capacity, int inputVectorLength)
+{
+    BitSlices *slices = (BitSlices *)malloc(sizeof(BitSlices));
+    if (!slices)
+    {
+        printf("Memory allocation failed for bit slices.\n");
+        exit(1);
+    }
+    int words = (capacity + 63) / 64;
+    slices->inputVectorsCount = 0;
+    slices->inputVectorLength = inputVectorLength;
+    slices->words = 0;
+    slices->capacity = capacity;
+    slices->ones = (unsigned long long **)malloc(inputVectorLength * sizeof(unsigned long long *));
+    slices->zeros = (unsigned long long **)malloc(inputVectorLength * sizeof(unsigned long long *));
+    slices->members = (unsigned long long *)calloc(words + 1, sizeof(unsigned long long));
+    slices->pending = (unsigned long long *)calloc(words + 1, sizeof(unsigned long long));
+    if (!slices->ones || !slices->zeros || !slices->members || !slices->pending)
+    {
+        printf("Memory allocation failed for bit slices.\n");
+        exit(1);
+    }
+
+    for (int k = 0; k < inputVectorLength; k++)
+    {
+        slices->ones[k] = (unsigned long long *)calloc(words + 1, sizeof(unsigned long long));
+        slices->zeros[k] = (unsigned long long *)calloc(words + 1, sizeof(unsigned long long));
+        if (!slices->ones[k] || !slices->zeros[k])
+        {
+            printf("Memory allocation failed for bit slice %d.\n", k);
+            exit(1);
+        }
+    }
+    return slices;
+}
+
+// Function to fill the bit-sliced view with vectors, replacing what it held before
+void loadBitSlices(BitSlices *slices, char **vectors, int inputVectorsCount)
+{
+    slices->inputVectorsCount = inputVectorsCount;
+    slices->words = (inputVectorsCount + 63) / 64;
+    for (int k = 0; k < slices->inputVectorLength; k++)
+    {
+        memset(slices->ones[k], 0, slices->words * sizeof(unsigned long long));
+        memset(slices->zeros[k], 0, slices->words * sizeof(unsigned long long));
+    }
+
+    for (int v = 0; v < inputVectorsCount; v++)
+    {
+        unsigned long long bit = 1ULL << (v % 64);
+        for (int k = 0; k < slices->inputVectorLength; k++)
         {
-            graph[vertex][j] = graph[j][vertex] = 0;
+            if (vectors[v][k] == '1')
+                slices->ones[k][v / 64] |= bit;
+            else if (vectors[v][k] == '0')
+                slices->zeros[k][v / 64] |= bit;
         }
     }
 }
 
+// Function to build the bit-sliced view of the vectors
+BitSlices *buildBitSlices(char **vectors, int inputVectorsCount, int inputVectorLength)
+{
+    BitSlices *slices = createBitSlices(inputVectorsCount, inputVectorLength);
+    loadBitSlices(slices, vectors, inputVectorsCount);
+    return slices;
+}
+
+void freeBitSlices(BitSlices *slices)
+{
+    for (int k = 0; k < slices->inputVectorLength; k++)
+    {
+        free(slices->ones[k]);
+        free(slices->zeros[k]);
+    }
+    free(slices->ones);
+    free(slices->zeros);
+    free(slices->members);
+    free(slices->pending);
+    free(slices);
+}
+
+// Function to load a clique into the membership scratch bitset
+void loadCliqueMembers(BitSlices *slices, const int *clique)
+{
+    memset(slices->members, 0, slices->words * sizeof(unsigned long long));
+    for (int j = 0; clique[j] != -1; j++)
+    {
+        slices->members[clique[j] / 64] |= 1ULL << (clique[j] % 64);
+    }
+}
+
+// Function to count the members holding a '1' and a '0' at one position; the rest are X
+void positionHistogram(const BitSlices *slices, int position, int *ones, int *zeros)
+{
+    *ones = *zeros = 0;
+    for (int w = 0; w < slices->words; w++)
+    {
+        *ones += __builtin_popcountll(slices->ones[position][w] & slices->members[w]);
+        *zeros += __builtin_popcountll(slices->zeros[position][w] & slices->members[w]);
+    }
+}
+
 // Function to merge vectors in a clique to a compressed value
-char *mergeClique(char **vectors, int *clique, int inputVectorLength)
+char *mergeClique(BitSlices *slices, const int *clique)
 {
+    int inputVectorLength = slices->inputVectorLength;
     char *merged = (char *)malloc((inputVectorLength + 1) * sizeof(char));
+    loadCliqueMembers(slices, clique);
     for (int i = 0; i < inputVectorLength; i++)
     {
-        int hasOne = 0, hasZero = 0;
-        for (int j = 0; clique[j] != -1; j++)
-        {
-            if (vectors[clique[j]][i] == '1')
-            {
-                hasOne = 1;
-                break;
-            }
-            else if (vectors[clique[j]][i] == '0')
-            {
-                hasZero = 1;
-            }
-        }
-        merged[i] = hasOne ? '1' : (hasZero ? '0' : 'X');
+        int ones, zeros;
+        positionHistogram(slices, i, &ones, &zeros);
+        merged[i] = ones ? '1' : (zeros ? '0' : 'X');
     }
     merged[inputVectorLength] = '\0';
     return merged;
 }
 
-void outputCliquesToFile(const char *outputFileName, int **cliques, int numCliques, char **vectors, int inputVectorLength)
+// Function to merge every clique into its dictionary entry
+char **mergeCliques(BitSlices *slices, int **cliques, int numCliques)
+{
+    char **entries = (char **)malloc((numCliques + 1) * sizeof(char *));
+    if (!entries)
+    {
+        printf("Memory allocation failed for dictionary entries.\n");
+        exit(1);
+    }
+    for (int i = 0; i < numCliques; i++)
+        entries[i] = mergeClique(slices, cliques[i]);
+    return entries;
+}
+
+void freeEntries(char **entries, int numEntries)
+{
+    for (int i = 0; i < numEntries; i++)
+        free(entries[i]);
+    free(entries);
+}
+
+// Function to count, for each entry in order, the vectors it is the first compatible entry for
+// A vector is compatible with an entry unless it holds the opposite value at one of the entry's specified
+// positions, so the compatible set is the AND of ~zeros[k] (entry '1') or ~ones[k] (entry '0').
+// hits[numEntries] receives the vectors no entry covers; the return value is the number covered.
+long long entryHits(BitSlices *slices, char **entries, int numEntries, long long *hits)
+{
+    int words = slices->words;
+    unsigned long long *compatible = slices->members;
+    unsigned long long *pending = slices->pending;
+    long long covered = 0;
+
+    memset(pending, 0xff, words * sizeof(unsigned long long));
+    if (slices->inputVectorsCount % 64)
+        pending[words - 1] = (1ULL << (slices->inputVectorsCount % 64)) - 1;
+
+    for (int e = 0; e < numEntries; e++)
+    {
+        memcpy(compatible, pending, words * sizeof(unsigned long long));
+        for (int k = 0; k < slices->inputVectorLength; k++)
+        {
+            if (entries[e][k] == 'X')
+                continue;
+            unsigned long long *conflict = (entries[e][k] == '1') ? slices->zeros[k] : slices->ones[k];
+            for (int w = 0; w < words; w++)
+                compatible[w] &= ~conflict[w];
+        }
+
+        hits[e] = 0;
+        for (int w = 0; w < words; w++)
+        {
+            hits[e] += __builtin_popcountll(compatible[w]);
+            pending[w] &= ~compatible[w];
+        }
+        covered += hits[e];
+    }
+    hits[numEntries] = slices->inputVectorsCount - covered;
+    return covered;
+}
+
+void outputCliquesToFile(const char *outputFileName, char **entries, int numEntries)
 {
     FILE *file = fopen(outputFileName, "w");
     if (!file)
@@ -170,97 +532,990 @@ void outputCliquesToFile(const char *outputFileName, int **cliques, int numCliqu
         exit(1);
     }
 
-    //inorder to check the values uncomment this and try running it
+    for (int i = 0; i < numEntries; i++)
+    {
+        fprintf(file, "Clique %d: %s\n", i + 1, entries[i]);
+    }
+    fclose(file);
+}
 
-    // int count;
+// Function to print per-entry statistics from the per-position 0/1/X histograms
+// X fills are member bits that were X but are specified by the entry
+void reportCliqueStats(int **cliques, int numCliques, BitSlices *slices)
+{
+    int covered = 0;
     for (int i = 0; i < numCliques; i++)
     {
-        // count = 0;
-        // fprintf(file, "Clique %d: {", i + 1);
-        for (int j = 0; cliques[i][j] != -1; j++)
+        loadCliqueMembers(slices, cliques[i]);
+        int size = 0, specified = 0, fills = 0;
+        for (int w = 0; w < slices->words; w++)
+            size += __builtin_popcountll(slices->members[w]);
+
+        for (int k = 0; k < slices->inputVectorLength; k++)
         {
-            // count++;
-            // fprintf(file, "%d", cliques[i][j] + 1);
-            if (cliques[i][j + 1] != -1)
+            int ones, zeros;
+            positionHistogram(slices, k, &ones, &zeros);
+            if (ones || zeros)
             {
-                // fprintf(file, ", ");
+                specified++;
+                fills += size - ones - zeros;
             }
         }
-        // fprintf(file, "}\n");
-        // fprintf(file, "Clique %d size: %d\n", i + 1, count);
+        covered += size;
+        printf("Clique %d: %d vectors, %d of %d bits specified, %d X fills\n",
+               i + 1, size, specified, slices->inputVectorLength, fills);
+    }
+    printf("Clique members: %d of %d vectors (%.2f%%)\n", covered, slices->inputVectorsCount,
+           slices->inputVectorsCount ? 100.0 * covered / slices->inputVectorsCount : 0.0);
+}
+
+// Function to extract cliques from the graph until maxCliques are found or no vertices remain
+// Each clique is copied from ws->best into the workspace arena, so the loop itself never allocates
+void extractCliques(Graph *graph, int *available, CliqueWorkspace *ws, int **cliques, int *numCliques, int maxCliques)
+{
+    while (*numCliques < maxCliques)
+    {
+        int cliqueSize = largestClique(graph, available, ws);
+
+        if (cliqueSize == 0)
+            break;
+
+        int *clique = ws->arena + ws->arenaUsed;
+        memcpy(clique, ws->best, (cliqueSize + 1) * sizeof(int));
+        ws->arenaUsed += cliqueSize + 1;
 
-        char *compressedValue = mergeClique(vectors, cliques[i], inputVectorLength);
-        fprintf(file, "Clique %d: %s\n", i + 1, compressedValue);
-        free(compressedValue);
+        cliques[(*numCliques)++] = clique;
+        removeCliquesFromGraph(clique, graph, available);
     }
-    fclose(file);
 }
 
-int main(int argc, char *argv[])
+// Function to move separately allocated cliques (loaded or grown in incremental mode) into the workspace arena
+void moveCliquesToArena(CliqueWorkspace *ws, int **cliques, int numCliques)
 {
-    if (argc != 5)
+    for (int i = 0; i < numCliques; i++)
     {
-        printf("Usage: ./dict <input_file> <max_cliques> <vector_length> <output_file>\n");
-        return 1;
+        int size = 0;
+        while (cliques[i][size] != -1)
+            size++;
+
+        int *clique = ws->arena + ws->arenaUsed;
+        memcpy(clique, cliques[i], (size + 1) * sizeof(int));
+        ws->arenaUsed += size + 1;
+        free(cliques[i]);
+        cliques[i] = clique;
     }
+}
 
-    const char *inputFile = argv[1];
-    int maxCliques = atoi(argv[2]);
-    int vectorLength = atoi(argv[3]);
-    const char *outputFile = argv[4];
+// Function to estimate the peak memory in bytes for n vectors with the given graph layout
+long long estimateMemory(int inputVectorsCount, int inputVectorLength, int maxCliques, int packed)
+{
+    long long n = inputVectorsCount;
+    long long words = (n + 63) / 64 + 1;
+    long long overhead = 16; // per allocation
+    long long bytes = n * (inputVectorLength + 1 + overhead + sizeof(char *)); // vectors
+    bytes += 2LL * inputVectorLength * (words * 8 + overhead);               // bit slices
+    bytes += n * sizeof(int);                                                // available
+    bytes += (3 * n + maxCliques) * sizeof(int) + words * 8;                 // workspace and arena
+    bytes += (long long)maxCliques * (sizeof(int *) + sizeof(int));          // clique pointers, flags
+    if (packed)
+        bytes += n * (words * 8 + overhead + sizeof(unsigned long long *));
+    else
+        bytes += n * (n * sizeof(int) + overhead + sizeof(int *));
+    return bytes;
+}
 
-    if (vectorLength != 8 && vectorLength != 16 && vectorLength != 32 && vectorLength != 64)
+// Function to pick the graph layout that fits memLimitMB (0 means no limit)
+// extraBytes covers buffers held alongside the graph, such as the streaming buffers of approximate mode
+// The int matrix is kept when it fits; packed rows are the fallback
+int chooseGraphLayout(int inputVectorsCount, int inputVectorLength, int maxCliques, long long extraBytes, long long memLimitMB)
+{
+    if (memLimitMB <= 0)
+        return 0;
+
+    long long limitKB = memLimitMB * 1024;
+    long long matrixKB = (estimateMemory(inputVectorsCount, inputVectorLength, maxCliques, 0) + extraBytes + 1023) / 1024;
+    long long packedKB = (estimateMemory(inputVectorsCount, inputVectorLength, maxCliques, 1) + extraBytes + 1023) / 1024;
+    if (matrixKB <= limitKB)
     {
-        printf("Error: Invalid vector length. Must be 8, 16, 32, or 64.\n");
+        printf("Using matrix graph for %d vectors (about %lld KB of %lld KB)\n", inputVectorsCount, matrixKB, limitKB);
+        return 0;
+    }
+    if (packedKB <= limitKB)
+    {
+        printf("Using packed graph for %d vectors (about %lld KB of %lld KB)\n", inputVectorsCount, packedKB, limitKB);
         return 1;
     }
+    printf("Error: %d vectors need about %lld KB, more than the memory limit of %lld KB\n",
+           inputVectorsCount, packedKB, limitKB);
+    exit(1);
+}
 
-    int inputVectorsCount;
-    char **vectors = readInputVectorsFromInputFile(inputFile, &inputVectorsCount, vectorLength);
-    // printf("%d %d\n",actualVectorCount, inputVectorsCount);
-    int **graph = constructGraph(vectors, inputVectorsCount, vectorLength);
-    int *available = (int *)calloc(inputVectorsCount, sizeof(int));
-    for (int i = 0; i < inputVectorsCount; i++)
-        available[i] = 1;
+// Function to append a vertex to a -1 terminated clique
+void appendToClique(int **clique, int vertex)
+{
+    int size = 0;
+    while ((*clique)[size] != -1)
+        size++;
 
-    int **cliques = (int **)malloc(maxCliques * sizeof(int *));
-    int numCliques = 0;
+    int *grown = (int *)realloc(*clique, (size + 2) * sizeof(int));
+    if (!grown)
+    {
+        printf("Memory allocation failed for clique.\n");
+        exit(1);
+    }
+    grown[size] = vertex;
+    grown[size + 1] = -1;
+    *clique = grown;
+}
+
+// Function to save the vectors, clique assignments and remaining graph for a later incremental run
+//
+// Layout (text):
+//   CLIQUEQUEST_STATE 1
+//   <vector_length> <vector_count> <num_cliques>
+//   one vector per line
+//   one clique per line: <size> <vertex> <vertex> ...
+//   one line per vertex left out of every clique: <vertex> <hex bitmap of its row>
+void saveState(const char *stateFileName, char **vectors, int inputVectorsCount, int inputVectorLength,
+               const Graph *graph, int *available, int **cliques, int numCliques)
+{
+    FILE *file = fopen(stateFileName, "w");
+    if (!file)
+    {
+        printf("Error: Could not open or create file %s for writing\n", stateFileName);
+        exit(1);
+    }
 
-    while (numCliques < maxCliques)
+    fprintf(file, "CLIQUEQUEST_STATE 1\n");
+    fprintf(file, "%d %d %d\n", inputVectorLength, inputVectorsCount, numCliques);
+    for (int i = 0; i < inputVectorsCount; i++)
     {
-        int cliqueSize;
-        int *clique = largestClique(graph, inputVectorsCount, available, &cliqueSize);
+        fprintf(file, "%s\n", vectors[i]);
+    }
 
-        if (cliqueSize == 0)
+    for (int i = 0; i < numCliques; i++)
+    {
+        int size = 0;
+        while (cliques[i][size] != -1)
+            size++;
+        fprintf(file, "%d", size);
+        for (int j = 0; j < size; j++)
         {
-            free(clique);
-            break;
+            fprintf(file, " %d", cliques[i][j]);
         }
+        fprintf(file, "\n");
+    }
+
+    for (int v = 0; v < inputVectorsCount; v++)
+    {
+        if (!available[v])
+            continue;
 
-        cliques[numCliques++] = clique;
-        removeCliquesFromGraph(clique, graph, inputVectorsCount, available);
+        fprintf(file, "%d ", v);
+        for (int j = 0; j < inputVectorsCount; j += 4)
+        {
+            int nibble = 0;
+            for (int k = 0; k < 4 && j + k < inputVectorsCount; k++)
+            {
+                if (hasEdge(graph, v, j + k))
+                    nibble |= 1 << k;
+            }
+            fputc("0123456789abcdef"[nibble], file);
+        }
+        fprintf(file, "\n");
     }
+    fclose(file);
+}
 
-    if (numCliques < maxCliques)
+// Function to read the number of saved vectors from a state file header
+int stateVectorCount(const char *stateFileName)
+{
+    FILE *file = fopen(stateFileName, "r");
+    if (!file)
     {
-        printf("Only %d dictionary entries are possible\n", numCliques);
+        printf("Error: Could not open file %s\n", stateFileName);
+        exit(1);
     }
 
-    outputCliquesToFile(outputFile, cliques, numCliques, vectors, vectorLength);
+    int version, savedLength, count;
+    if (fscanf(file, "CLIQUEQUEST_STATE %d", &version) != 1 || fscanf(file, "%d %d", &savedLength, &count) != 2)
+    {
+        printf("Error: %s is not a valid state file\n", stateFileName);
+        exit(1);
+    }
+    fclose(file);
+    return count;
+}
 
-    for (int i = 0; i < inputVectorsCount; i++)
+// Function to load a saved state, leaving room for extraVectors more vectors in the vector and graph arrays
+char **loadState(const char *stateFileName, int inputVectorLength, int extraVectors, int packed, int *inputVectorsCount,
+                 Graph **graphOut, int **availableOut, int **cliques, int *numCliques, int maxCliques)
+{
+    FILE *file = fopen(stateFileName, "r");
+    if (!file)
     {
-        free(vectors[i]);
-        free(graph[i]);
+        printf("Error: Could not open file %s\n", stateFileName);
+        exit(1);
     }
-    free(vectors);
-    free(graph);
-    free(available);
 
-    for (int i = 0; i < numCliques; i++)
+    int version, savedLength, count, savedCliques;
+    if (fscanf(file, "CLIQUEQUEST_STATE %d", &version) != 1 || version != 1 ||
+        fscanf(file, "%d %d %d", &savedLength, &count, &savedCliques) != 3)
     {
-        free(cliques[i]);
+        printf("Error: %s is not a valid state file\n", stateFileName);
+        exit(1);
+    }
+    if (savedLength != inputVectorLength)
+    {
+        printf("Error: State file uses vector length %d, not %d\n", savedLength, inputVectorLength);
+        exit(1);
     }
+    if (savedCliques > maxCliques)
+    {
+        printf("Error: State file already holds %d dictionary entries, more than the %d requested\n", savedCliques, maxCliques);
+        exit(1);
+    }
+
+    int capacity = count + extraVectors;
+    char **vectors = (char **)malloc(capacity * sizeof(char *));
+    int *available = (int *)malloc(capacity * sizeof(int));
+    if (!vectors || !available)
+    {
+        printf("Memory allocation failed for state.\n");
+        exit(1);
+    }
+
+    char line[66];
+    for (int i = 0; i < count; i++)
+    {
+        if (fscanf(file, "%65s", line) != 1 || (int)strlen(line) != inputVectorLength)
+        {
+            printf("Error: %s is truncated at vector %d\n", stateFileName, i);
+            exit(1);
+        }
+        vectors[i] = strdup(line);
+        available[i] = 1;
+    }
+
+    Graph *graph = createGraph(capacity, packed);
+
+    *numCliques = 0;
+    for (int i = 0; i < savedCliques; i++)
+    {
+        int size;
+        if (fscanf(file, "%d", &size) != 1 || size < 1 || size > count)
+        {
+            printf("Error: %s has a malformed clique %d\n", stateFileName, i + 1);
+            exit(1);
+        }
+        int *clique = (int *)malloc((size + 1) * sizeof(int));
+        for (int j = 0; j < size; j++)
+        {
+            if (fscanf(file, "%d", &clique[j]) != 1 || clique[j] < 0 || clique[j] >= count)
+            {
+                printf("Error: %s has a malformed clique %d\n", stateFileName, i + 1);
+                exit(1);
+            }
+            available[clique[j]] = 0;
+        }
+        clique[size] = -1;
+        cliques[(*numCliques)++] = clique;
+    }
+
+    int v;
+    int rowLength = (count + 3) / 4;
+    char *row = (char *)malloc(rowLength + 2);
+    while (fscanf(file, "%d ", &v) == 1)
+    {
+        if (v < 0 || v >= count || !fgets(row, rowLength + 1, file) || (int)strlen(row) != rowLength)
+        {
+            printf("Error: %s has a malformed graph row\n", stateFileName);
+            exit(1);
+        }
+        for (int j = 0; j < count; j++)
+        {
+            char c = row[j / 4];
+            int nibble = (c >= 'a') ? c - 'a' + 10 : c - '0';
+            if ((nibble >> (j % 4)) & 1)
+                addEdge(graph, v, j);
+        }
+    }
+    free(row);
+    fclose(file);
+
+    *inputVectorsCount = count;
+    *graphOut = graph;
+    *availableOut = available;
+    return vectors;
+}
+
+// Function to fold new vectors into existing cliques whose merged value they are compatible with
+// Entries whose merged value gains specified bits are flagged in changed
+void absorbNewVectors(char **vectors, int firstNew, int inputVectorsCount, int inputVectorLength,
+                      int **cliques, int numCliques, int *available, int *changed)
+{
+    // Every saved clique member comes before firstNew
+    BitSlices *slices = buildBitSlices(vectors, firstNew, inputVectorLength);
+    char **merged = mergeCliques(slices, cliques, numCliques);
+    freeBitSlices(slices);
+
+    for (int v = firstNew; v < inputVectorsCount; v++)
+    {
+        for (int i = 0; i < numCliques; i++)
+        {
+            if (!isCompatible(vectors[v], merged[i], inputVectorLength))
+                continue;
+
+            appendToClique(&cliques[i], v);
+            available[v] = 0;
+            for (int k = 0; k < inputVectorLength; k++)
+            {
+                if (merged[i][k] == 'X' && vectors[v][k] != 'X')
+                {
+                    merged[i][k] = vectors[v][k];
+                    changed[i] = 1;
+                }
+            }
+            break;
+        }
+    }
+
+    freeEntries(merged, numCliques);
+}
+
+// Function to add edges for new vectors that were not absorbed, against every vector still outside a clique
+void extendGraph(Graph *graph, char **vectors, int firstNew, int inputVectorsCount, int inputVectorLength, int *available)
+{
+    for (int v = firstNew; v < inputVectorsCount; v++)
+    {
+        if (!available[v])
+            continue;
+
+        for (int u = 0; u < v; u++)
+        {
+            if (available[u] && isCompatible(vectors[u], vectors[v], inputVectorLength))
+            {
+                addEdge(graph, u, v);
+            }
+        }
+    }
+}
+
+// Function to write only the dictionary entries that are new or whose merged value changed
+void outputDeltaToFile(const char *outputFileName, char **entries, int numEntries, int *changed)
+{
+    FILE *file = fopen(outputFileName, "w");
+    if (!file)
+    {
+        printf("Error: Could not open or create file %s for writing\n", outputFileName);
+        exit(1);
+    }
+
+    for (int i = 0; i < numEntries; i++)
+    {
+        if (changed[i])
+            fprintf(file, "Clique %d: %s\n", i + 1, entries[i]);
+    }
+    fclose(file);
+}
+
+// Function to compute Huffman code lengths for the given weights
+void huffmanCodeLengths(const int *weights, int count, int *lengths)
+{
+    // Nodes 0..count-1 are leaves, the rest are internal; merge the two lightest roots until one is left
+    int nodes = 2 * count - 1;
+    long long *weight = (long long *)malloc(nodes * sizeof(long long));
+    int *parent = (int *)malloc(nodes * sizeof(int));
+    for (int i = 0; i < count; i++)
+        weight[i] = weights[i];
+    for (int i = 0; i < nodes; i++)
+        parent[i] = -1;
+
+    for (int next = count; next < nodes; next++)
+    {
+        int a = -1, b = -1;
+        for (int i = 0; i < next; i++)
+        {
+            if (parent[i] != -1)
+                continue;
+            if (a == -1 || weight[i] < weight[a])
+            {
+                b = a;
+                a = i;
+            }
+            else if (b == -1 || weight[i] < weight[b])
+            {
+                b = i;
+            }
+        }
+        weight[next] = weight[a] + weight[b];
+        parent[a] = parent[b] = next;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        lengths[i] = 0;
+        for (int n = i; parent[n] != -1; n = parent[n])
+            lengths[i]++;
+    }
+    free(weight);
+    free(parent);
+}
+
+// Function to model test application with the decoder for every dictionary size from 1 to numEntries
+//
+// Codewords: a 1-bit flag, then either an entry codeword (hit) or the raw word (miss).
+//   fixed:   entry codeword is a ceil(log2 D)-bit index
+//   huffman: selective Huffman over the D entries, weighted by clique size
+// The tester sends one bit per clock on a single channel. The decoder shifts one scan slice (one bit into
+// each of the scan chains) per clock, overlapped with receiving the next codeword, so a word takes
+// max(codeword bits, slices per word) clocks.
+// hits comes from entryHits, so every dictionary size is scored from one pass over the bit slices.
+void evaluateDictionary(const long long *hits, int inputVectorsCount, int inputVectorLength,
+                        const int *cliqueSizes, int numEntries, double testerMHz, int scanChains)
+{
+    int *lengths = (int *)malloc((numEntries + 1) * sizeof(int));
+    if (!lengths)
+    {
+        printf("Memory allocation failed for evaluation.\n");
+        exit(1);
+    }
+
+    int slicesPerWord = (inputVectorLength + scanChains - 1) / scanChains;
+    long long rawBits = (long long)inputVectorsCount * inputVectorLength;
+    long long totalSlices = (long long)inputVectorsCount * slicesPerWord;
+    long long rawCycles = (long long)inputVectorsCount * (inputVectorLength > slicesPerWord ? inputVectorLength : slicesPerWord);
+
+    printf("Evaluation: %d vectors, %d scan chains, %d slices per word, %.1f MHz tester\n",
+           inputVectorsCount, scanChains, slicesPerWord, testerMHz);
+    printf("Uncompressed: %lld bits, %.2f cycles per slice, %.2f us\n",
+           rawBits, totalSlices ? (double)rawCycles / totalSlices : 0.0, rawCycles / testerMHz);
+    printf("%-4s %-8s %12s %10s %14s %12s\n", "D", "scheme", "bits", "ratio", "cycles/slice", "time (us)");
+
+    long long covered = 0;
+    for (int d = 1; d <= numEntries; d++)
+    {
+        covered += hits[d - 1];
+        long long misses = inputVectorsCount - covered;
+        int indexBits = 0;
+        while ((1 << indexBits) < d)
+            indexBits++;
+        huffmanCodeLengths(cliqueSizes, d, lengths);
+
+        for (int scheme = 0; scheme < 2; scheme++)
+        {
+            long long bits = misses * (1 + inputVectorLength);
+            long long cycles = misses * (1 + inputVectorLength > slicesPerWord ? 1 + inputVectorLength : slicesPerWord);
+            for (int e = 0; e < d; e++)
+            {
+                int codeword = 1 + (scheme == 0 ? indexBits : lengths[e]);
+                bits += hits[e] * codeword;
+                cycles += hits[e] * (codeword > slicesPerWord ? codeword : slicesPerWord);
+            }
+            printf("%-4d %-8s %12lld %9.2f%% %14.2f %12.2f\n", d, scheme == 0 ? "fixed" : "huffman", bits,
+                   rawBits ? 100.0 * (rawBits - bits) / rawBits : 0.0,
+                   totalSlices ? (double)cycles / totalSlices : 0.0, cycles / testerMHz);
+        }
+    }
+
+    free(lengths);
+}
+
+// Function to evaluate the dictionary formed by the cliques, using clique sizes as the Huffman weights
+void evaluateCliques(const long long *hits, int inputVectorsCount, int inputVectorLength, int **cliques, int numCliques,
+                     double testerMHz, int scanChains)
+{
+    int *sizes = (int *)calloc(numCliques + 1, sizeof(int));
+    for (int i = 0; i < numCliques; i++)
+    {
+        while (cliques[i][sizes[i]] != -1)
+            sizes[i]++;
+    }
+
+    evaluateDictionary(hits, inputVectorsCount, inputVectorLength, sizes, numCliques, testerMHz, scanChains);
+    free(sizes);
+}
+
+// Function to count the vectors in each stratum (number of specified, non-X, bits) in one pass over the file
+// stratumSizes must hold inputVectorLength + 1 counters; returns the number of vectors
+int countStrata(const char *inputFileName, int inputVectorLength, int *stratumSizes)
+{
+    FILE *file = fopen(inputFileName, "r");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", inputFileName);
+        exit(1);
+    }
+
+    char line[inputVectorLength + 2];
+    int inputVectorsCount = 0;
+    memset(stratumSizes, 0, (inputVectorLength + 1) * sizeof(int));
+    while (fscanf(file, "%s", line) != EOF)
+    {
+        int specified = 0;
+        for (int k = 0; k < inputVectorLength; k++)
+            specified += line[k] != 'X';
+        stratumSizes[specified]++;
+        inputVectorsCount++;
+    }
+    fclose(file);
+    return inputVectorsCount;
+}
+
+// Function to draw a random sample stratified by the number of specified bits, streaming the file once more
+// Each stratum gets a share of the sample proportional to its size (largest remainder rounding). Vectors are
+// kept by selection sampling (probability still needed / still unseen in their stratum), so only the sample
+// is held in memory.
+char **stratifiedSample(const char *inputFileName, int inputVectorLength, const int *stratumSizes,
+                        int inputVectorsCount, int sampleSize, unsigned int seed)
+{
+    int strataCount = inputVectorLength + 1;
+    int *quota = (int *)calloc(strataCount, sizeof(int));
+    int *unseen = (int *)malloc(strataCount * sizeof(int));
+    long long *remainder = (long long *)calloc(strataCount, sizeof(long long));
+    char **sample = (char **)malloc((sampleSize + 1) * sizeof(char *));
+    if (!quota || !unseen || !remainder || !sample)
+    {
+        printf("Memory allocation failed for sample.\n");
+        exit(1);
+    }
+
+    int assigned = 0;
+    for (int s = 0; s < strataCount && inputVectorsCount > 0; s++)
+    {
+        long long share = (long long)sampleSize * stratumSizes[s];
+        quota[s] = (int)(share / inputVectorsCount);
+        remainder[s] = share % inputVectorsCount;
+        assigned += quota[s];
+    }
+    while (assigned < sampleSize)
+    {
+        int best = -1;
+        for (int s = 0; s < strataCount; s++)
+        {
+            if (quota[s] < stratumSizes[s] && (best == -1 || remainder[s] > remainder[best]))
+                best = s;
+        }
+        quota[best]++;
+        remainder[best] = -1;
+        assigned++;
+    }
+    memcpy(unseen, stratumSizes, strataCount * sizeof(int));
+
+    FILE *file = fopen(inputFileName, "r");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", inputFileName);
+        exit(1);
+    }
+
+    srand(seed);
+    char line[inputVectorLength + 2];
+    int taken = 0;
+    while (taken < sampleSize && fscanf(file, "%s", line) != EOF)
+    {
+        int specified = 0;
+        for (int k = 0; k < inputVectorLength; k++)
+            specified += line[k] != 'X';
+
+        if (rand() % unseen[specified] < quota[specified])
+        {
+            sample[taken++] = strdup(line);
+            quota[specified]--;
+        }
+        unseen[specified]--;
+    }
+    fclose(file);
+
+    free(quota);
+    free(unseen);
+    free(remainder);
+    return sample;
+}
+
+// Function to stream the input file once and count, per entry, the vectors it is the first compatible entry for
+// Vectors are read in blocks that are bit-sliced and matched with entryHits
+#define STREAM_BLOCK 4096
+
+long long streamCoverage(const char *inputFileName, char **entries, int numEntries, int inputVectorLength,
+                         long long *hits, int *inputVectorsCount)
+{
+    FILE *file = fopen(inputFileName, "r");
+    if (!file)
+    {
+        printf("Error: Could not open file %s\n", inputFileName);
+        exit(1);
+    }
+
+    char *block = (char *)malloc(STREAM_BLOCK * (inputVectorLength + 2));
+    char **blockVectors = (char **)malloc(STREAM_BLOCK * sizeof(char *));
+    long long *blockHits = (long long *)malloc((numEntries + 1) * sizeof(long long));
+    if (!block || !blockVectors || !blockHits)
+    {
+        printf("Memory allocation failed for stream buffers.\n");
+        exit(1);
+    }
+    for (int i = 0; i < STREAM_BLOCK; i++)
+        blockVectors[i] = block + i * (inputVectorLength + 2);
+    BitSlices *slices = createBitSlices(STREAM_BLOCK, inputVectorLength);
+
+    long long covered = 0;
+    memset(hits, 0, (numEntries + 1) * sizeof(long long));
+    *inputVectorsCount = 0;
+    int filled;
+    do
+    {
+        filled = 0;
+        while (filled < STREAM_BLOCK && fscanf(file, "%s", blockVectors[filled]) != EOF)
+            filled++;
+
+        loadBitSlices(slices, blockVectors, filled);
+        covered += entryHits(slices, entries, numEntries, blockHits);
+        for (int e = 0; e <= numEntries; e++)
+            hits[e] += blockHits[e];
+        *inputVectorsCount += filled;
+    } while (filled == STREAM_BLOCK);
+
+    freeBitSlices(slices);
+    free(block);
+    free(blockVectors);
+    free(blockHits);
+    fclose(file);
+    return covered;
+}
+
+// Function to estimate the bytes streamCoverage and the strata counters hold while streaming
+long long estimateStreamMemory(int inputVectorLength, int maxCliques)
+{
+    long long words = STREAM_BLOCK / 64 + 1;
+    long long bytes = (long long)STREAM_BLOCK * (inputVectorLength + 2 + sizeof(char *)); // block buffer
+    bytes += (2LL * inputVectorLength + 2) * words * 8;                                    // block slices
+    bytes += 2LL * (maxCliques + 1) * sizeof(long long);                                   // hit counters
+    bytes += 4LL * (inputVectorLength + 1) * sizeof(long long);                            // strata
+    return bytes;
+}
+
+// Function to run clique extraction on all vectors and return the entry coverage of the resulting dictionary
+int exactCoverage(char **vectors, int inputVectorsCount, int inputVectorLength, int maxCliques, int packed)
+{
+    Graph *graph = constructGraph(vectors, inputVectorsCount, inputVectorLength, packed);
+    CliqueWorkspace *ws = createWorkspace(inputVectorsCount, maxCliques);
+    int *available = (int *)malloc(inputVectorsCount * sizeof(int));
+    int **cliques = (int **)malloc(maxCliques * sizeof(int *));
+    int numCliques = 0;
+    for (int i = 0; i < inputVectorsCount; i++)
+        available[i] = 1;
+
+    extractCliques(graph, available, ws, cliques, &numCliques, maxCliques);
+
+    BitSlices *slices = buildBitSlices(vectors, inputVectorsCount, inputVectorLength);
+    char **entries = mergeCliques(slices, cliques, numCliques);
+    long long *hits = (long long *)malloc((numCliques + 1) * sizeof(long long));
+    long long covered = entryHits(slices, entries, numCliques, hits);
+    freeBitSlices(slices);
+
+    freeEntries(entries, numCliques);
+    free(hits);
+    freeGraph(graph);
+    freeWorkspace(ws);
+    free(available);
+    free(cliques);
+    return (int)covered;
+}
+
+// Function to select the dictionary from a stratified sample and report its true coverage on the full test set
+void runApproximate(const char *inputFile, int maxCliques, int vectorLength, const char *outputFile,
+                    int sampleSize, unsigned int seed, int compare, int stats, long long memLimitMB,
+                    double testerMHz, int scanChains)
+{
+    int *stratumSizes = (int *)malloc((vectorLength + 1) * sizeof(int));
+    int inputVectorsCount = countStrata(inputFile, vectorLength, stratumSizes);
+    if (sampleSize > inputVectorsCount)
+        sampleSize = inputVectorsCount;
+
+    // Check the full run against the budget before doing any work when it will be needed
+    // The sample run holds the sample plus the streaming buffers, never the full test set
+    int fullPacked = compare ? chooseGraphLayout(inputVectorsCount, vectorLength, maxCliques, 0, memLimitMB) : 0;
+    int packed = chooseGraphLayout(sampleSize, vectorLength, maxCliques, estimateStreamMemory(vectorLength, maxCliques), memLimitMB);
+
+    char **sampleVectors = stratifiedSample(inputFile, vectorLength, stratumSizes, inputVectorsCount, sampleSize, seed);
+    free(stratumSizes);
+
+    Graph *graph = constructGraph(sampleVectors, sampleSize, vectorLength, packed);
+    CliqueWorkspace *ws = createWorkspace(sampleSize, maxCliques);
+    int *available = (int *)malloc((sampleSize + 1) * sizeof(int));
+    int **cliques = (int **)malloc((maxCliques + 1) * sizeof(int *));
+    int numCliques = 0;
+    for (int i = 0; i < sampleSize; i++)
+        available[i] = 1;
+
+    extractCliques(graph, available, ws, cliques, &numCliques, maxCliques);
+
+    if (numCliques < maxCliques)
+    {
+        printf("Only %d dictionary entries are possible\n", numCliques);
+    }
+
+    BitSlices *slices = buildBitSlices(sampleVectors, sampleSize, vectorLength);
+    char **entries = mergeCliques(slices, cliques, numCliques);
+    outputCliquesToFile(outputFile, entries, numCliques);
+    if (stats)
+        reportCliqueStats(cliques, numCliques, slices);
+
+    long long *hits = (long long *)malloc((numCliques + 1) * sizeof(long long));
+    long long sampleCovered = entryHits(slices, entries, numCliques, hits);
+    freeBitSlices(slices);
+
+    int streamedCount;
+    long long covered = streamCoverage(inputFile, entries, numCliques, vectorLength, hits, &streamedCount);
+    if (testerMHz > 0)
+        evaluateCliques(hits, streamedCount, vectorLength, cliques, numCliques, testerMHz, scanChains);
+
+    double estimate = sampleSize ? 100.0 * sampleCovered / sampleSize : 0.0;
+    double actual = streamedCount ? 100.0 * covered / streamedCount : 0.0;
+
+    printf("Sampled %d of %d vectors (seed %u)\n", sampleSize, streamedCount, seed);
+    printf("Estimated coverage from sample: %.2f%%\n", estimate);
+    printf("Coverage: %lld of %d vectors compatible with an entry (%.2f%%), estimate error %+.2f points\n", covered,
+           streamedCount, actual, estimate - actual);
+
+    freeEntries(entries, numCliques);
+    free(hits);
+    for (int i = 0; i < sampleSize; i++)
+        free(sampleVectors[i]);
+    free(sampleVectors);
+    freeGraph(graph);
+    freeWorkspace(ws);
+    free(available);
+    free(cliques);
+
+    // The full run needs every vector in memory, so it is only loaded once the sample run is freed
+    if (compare)
+    {
+        char **vectors = readInputVectorsFromInputFile(inputFile, &inputVectorsCount, vectorLength);
+        int exactCovered = exactCoverage(vectors, inputVectorsCount, vectorLength, maxCliques, fullPacked);
+        double exact = inputVectorsCount ? 100.0 * exactCovered / inputVectorsCount : 0.0;
+        printf("Full run coverage: %d of %d vectors compatible with an entry (%.2f%%), approximate mode is %+.2f points\n",
+               exactCovered, inputVectorsCount, exact, actual - exact);
+        for (int i = 0; i < inputVectorsCount; i++)
+            free(vectors[i]);
+        free(vectors);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Usage: ./dict <input_file> <max_cliques> <vector_length> <output_file> [--incremental <state_file>] [--save-state <state_file>] [--sample <size> [--seed <seed>] [--compare]] [--stats] [--mem-limit <MB>] [--evaluate <tester_MHz> <scan_chains>]\n");
+        return 1;
+    }
+
+    const char *inputFile = argv[1];
+    int maxCliques = atoi(argv[2]);
+    int vectorLength = atoi(argv[3]);
+    const char *outputFile = argv[4];
+    const char *loadStateFile = NULL;
+    const char *saveStateFile = NULL;
+    int sampleSize = 0;
+    unsigned int seed = 1;
+    int seedGiven = 0;
+    int compare = 0;
+    int stats = 0;
+    long long memLimitMB = 0;
+    double testerMHz = 0;
+    int scanChains = 0;
+
+    for (int i = 5; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--incremental") == 0 && i + 1 < argc)
+        {
+            loadStateFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--save-state") == 0 && i + 1 < argc)
+        {
+            saveStateFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc)
+        {
+            sampleSize = atoi(argv[++i]);
+            if (sampleSize <= 0)
+            {
+                printf("Error: Sample size must be positive.\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+            seedGiven = 1;
+        }
+        else if (strcmp(argv[i], "--compare") == 0)
+        {
+            compare = 1;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            stats = 1;
+        }
+        else if (strcmp(argv[i], "--evaluate") == 0 && i + 2 < argc)
+        {
+            testerMHz = atof(argv[++i]);
+            scanChains = atoi(argv[++i]);
+            if (testerMHz <= 0 || scanChains <= 0)
+            {
+                printf("Error: Tester clock and scan chain count must be positive.\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--mem-limit") == 0 && i + 1 < argc)
+        {
+            memLimitMB = atoll(argv[++i]);
+            if (memLimitMB <= 0)
+            {
+                printf("Error: Memory limit must be a positive number of MB.\n");
+                return 1;
+            }
+        }
+        else
+        {
+            printf("Error: Unknown or incomplete option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (vectorLength != 8 && vectorLength != 16 && vectorLength != 32 && vectorLength != 64)
+    {
+        printf("Error: Invalid vector length. Must be 8, 16, 32, or 64.\n");
+        return 1;
+    }
+
+    if (sampleSize == 0 && (seedGiven || compare))
+    {
+        printf("Error: --seed and --compare require --sample.\n");
+        return 1;
+    }
+
+    if (sampleSize > 0)
+    {
+        if (loadStateFile || saveStateFile)
+        {
+            printf("Error: --sample cannot be combined with --incremental or --save-state.\n");
+            return 1;
+        }
+        runApproximate(inputFile, maxCliques, vectorLength, outputFile, sampleSize, seed, compare, stats, memLimitMB, testerMHz, scanChains);
+        return 0;
+    }
+
+    int inputVectorsCount;
+    char **vectors;
+    Graph *graph;
+    int *available;
+    CliqueWorkspace *ws;
+    int **cliques = (int **)malloc(maxCliques * sizeof(int *));
+    int *changed = (int *)calloc(maxCliques, sizeof(int));
+    int numCliques = 0;
+
+    if (loadStateFile)
+    {
+        // New vectors are appended after the saved ones; only they need compatibility checks
+        int newCount;
+        char **newVectors = readInputVectorsFromInputFile(inputFile, &newCount, vectorLength);
+        int totalCount = stateVectorCount(loadStateFile) + newCount;
+        int packed = chooseGraphLayout(totalCount, vectorLength, maxCliques, 0, memLimitMB);
+        vectors = loadState(loadStateFile, vectorLength, newCount, packed, &inputVectorsCount, &graph, &available, cliques, &numCliques, maxCliques);
+
+        int firstNew = inputVectorsCount;
+        for (int i = 0; i < newCount; i++)
+        {
+            vectors[inputVectorsCount] = newVectors[i];
+            available[inputVectorsCount++] = 1;
+        }
+        free(newVectors);
+
+        int savedCliques = numCliques;
+        absorbNewVectors(vectors, firstNew, inputVectorsCount, vectorLength, cliques, numCliques, available, changed);
+        int absorbed = 0;
+        for (int i = firstNew; i < inputVectorsCount; i++)
+            absorbed += !available[i];
+        extendGraph(graph, vectors, firstNew, inputVectorsCount, vectorLength, available);
+        ws = createWorkspace(inputVectorsCount, maxCliques);
+        moveCliquesToArena(ws, cliques, numCliques);
+        extractCliques(graph, available, ws, cliques, &numCliques, maxCliques);
+        for (int i = savedCliques; i < numCliques; i++)
+            changed[i] = 1;
+
+        int deltaEntries = 0;
+        for (int i = 0; i < numCliques; i++)
+            deltaEntries += changed[i];
+
+        BitSlices *slices = buildBitSlices(vectors, inputVectorsCount, vectorLength);
+        char **entries = mergeCliques(slices, cliques, numCliques);
+        long long *hits = (long long *)malloc((numCliques + 1) * sizeof(long long));
+        long long covered = entryHits(slices, entries, numCliques, hits);
+
+        printf("Added %d vectors (%d joined existing entries); %d of %d dictionary entries changed\n",
+               newCount, absorbed, deltaEntries, numCliques);
+        printf("Coverage: %lld of %d vectors compatible with an entry (%.2f%%)\n", covered, inputVectorsCount,
+               inputVectorsCount ? 100.0 * covered / inputVectorsCount : 0.0);
+        outputDeltaToFile(outputFile, entries, numCliques, changed);
+        if (stats)
+            reportCliqueStats(cliques, numCliques, slices);
+        if (testerMHz > 0)
+            evaluateCliques(hits, inputVectorsCount, vectorLength, cliques, numCliques, testerMHz, scanChains);
+        free(hits);
+        freeEntries(entries, numCliques);
+        freeBitSlices(slices);
+    }
+    else
+    {
+        vectors = readInputVectorsFromInputFile(inputFile, &inputVectorsCount, vectorLength);
+        // printf("%d %d\n",actualVectorCount, inputVectorsCount);
+        // Size everything up front so an oversized run fails here rather than partway through
+        int packed = chooseGraphLayout(inputVectorsCount, vectorLength, maxCliques, 0, memLimitMB);
+        graph = constructGraph(vectors, inputVectorsCount, vectorLength, packed);
+        ws = createWorkspace(inputVectorsCount, maxCliques);
+        available = (int *)calloc(inputVectorsCount, sizeof(int));
+        for (int i = 0; i < inputVectorsCount; i++)
+            available[i] = 1;
+
+        extractCliques(graph, available, ws, cliques, &numCliques, maxCliques);
+
+        if (numCliques < maxCliques)
+        {
+            printf("Only %d dictionary entries are possible\n", numCliques);
+        }
+
+        BitSlices *slices = buildBitSlices(vectors, inputVectorsCount, vectorLength);
+        char **entries = mergeCliques(slices, cliques, numCliques);
+        outputCliquesToFile(outputFile, entries, numCliques);
+        if (stats)
+            reportCliqueStats(cliques, numCliques, slices);
+        if (testerMHz > 0)
+        {
+            long long *hits = (long long *)malloc((numCliques + 1) * sizeof(long long));
+            entryHits(slices, entries, numCliques, hits);
+            evaluateCliques(hits, inputVectorsCount, vectorLength, cliques, numCliques, testerMHz, scanChains);
+            free(hits);
+        }
+        freeEntries(entries, numCliques);
+        freeBitSlices(slices);
+    }
+
+    if (saveStateFile)
+    {
+        saveState(saveStateFile, vectors, inputVectorsCount, vectorLength, graph, available, cliques, numCliques);
+    }
+
+    for (int i = 0; i < inputVectorsCount; i++)
+    {
+        free(vectors[i]);
+    }
+    free(vectors);
+    freeGraph(graph);
+    freeWorkspace(ws);
+    free(available);
+    free(changed);
     free(cliques);
 
     return 0;